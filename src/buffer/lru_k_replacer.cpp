@@ -12,12 +12,106 @@
 
 #include "buffer/lru_k_replacer.h"
 #include <cstddef>
+#include <cstring>
 #include <optional>
-#include <ostream>
+#include <thread>  // NOLINT
 #include "common/exception.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace bustub {
 
+namespace {
+
+/** How far ahead (in slots) the eviction scan prefetches the metadata columns. Far enough
+ *  to cover L2 latency at the scan's consumption rate, near enough not to thrash L1. */
+constexpr size_t kPrefetchDistance = 16;
+
+/** @brief Scalar min-key scan over slots [begin, end); also the tail loop for the SIMD path. */
+void ScanSlotsScalar(const uint8_t *present, const uint8_t *evictable, const size_t *keys, size_t begin, size_t end,
+                     size_t &best_key, size_t &best_slot) {
+  for (size_t i = begin; i < end; i++) {
+    if (i + kPrefetchDistance < end) {
+      __builtin_prefetch(&present[i + kPrefetchDistance], 0, 0);
+      __builtin_prefetch(&evictable[i + kPrefetchDistance], 0, 0);
+      __builtin_prefetch(&keys[i + kPrefetchDistance], 0, 0);
+    }
+    // eligible is 1 or 0, so (eligible - 1) is all-zeros or all-ones.
+    const auto eligible = static_cast<size_t>(present[i] & evictable[i]);
+    const size_t key = keys[i] | (eligible - 1);
+    const bool better = key < best_key;
+    best_key = better ? key : best_key;
+    best_slot = better ? i : best_slot;
+  }
+}
+
+/**
+ * @brief Find the minimum sort key among eligible slots and the slot holding it.
+ *
+ * Returns the maximum key value in `best_key` when no slot is eligible. With AVX2 the
+ * reduction runs four slots per iteration: the flag bytes are widened to 64-bit lanes,
+ * ineligible lanes are forced to the maximum key, and the running minima and their slot
+ * indices are kept in vector registers (unsigned compare via sign-bit flip, since AVX2
+ * only has a signed 64-bit compare). Real keys are distinct timestamps, so the final
+ * horizontal reduce never has to break a tie.
+ */
+void ScanSlots(const uint8_t *present, const uint8_t *evictable, const size_t *keys, size_t num_slots,
+               size_t &best_key, size_t &best_slot) {
+  static_assert(sizeof(size_t) == 8, "the sort-key scan assumes 64-bit keys");
+  size_t i = 0;
+#ifdef __AVX2__
+  if (num_slots >= 4) {
+    const __m256i sign_bit = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+    __m256i best_keys = _mm256_set1_epi64x(-1);
+    __m256i best_slots = _mm256_setzero_si256();
+    const __m256i lane_offsets = _mm256_set_epi64x(3, 2, 1, 0);
+    for (; i + 4 <= num_slots; i += 4) {
+      if (i + kPrefetchDistance < num_slots) {
+        __builtin_prefetch(&present[i + kPrefetchDistance], 0, 0);
+        __builtin_prefetch(&evictable[i + kPrefetchDistance], 0, 0);
+        __builtin_prefetch(&keys[i + kPrefetchDistance], 0, 0);
+      }
+      uint32_t present_bytes;
+      uint32_t evictable_bytes;
+      std::memcpy(&present_bytes, &present[i], sizeof(present_bytes));
+      std::memcpy(&evictable_bytes, &evictable[i], sizeof(evictable_bytes));
+      const __m256i eligible =
+          _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(static_cast<int>(present_bytes & evictable_bytes)));
+      const __m256i ineligible_mask = _mm256_cmpeq_epi64(eligible, _mm256_setzero_si256());
+      __m256i lane_keys = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&keys[i]));
+      lane_keys = _mm256_or_si256(lane_keys, ineligible_mask);
+      const __m256i lane_slots = _mm256_add_epi64(lane_offsets, _mm256_set1_epi64x(static_cast<long long>(i)));
+      const __m256i less = _mm256_cmpgt_epi64(_mm256_xor_si256(best_keys, sign_bit), _mm256_xor_si256(lane_keys, sign_bit));
+      best_keys = _mm256_blendv_epi8(best_keys, lane_keys, less);
+      best_slots = _mm256_blendv_epi8(best_slots, lane_slots, less);
+    }
+    alignas(32) size_t lane_best_keys[4];
+    alignas(32) size_t lane_best_slots[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lane_best_keys), best_keys);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lane_best_slots), best_slots);
+    for (size_t lane = 0; lane < 4; lane++) {
+      if (lane_best_keys[lane] < best_key) {
+        best_key = lane_best_keys[lane];
+        best_slot = lane_best_slots[lane];
+      }
+    }
+  }
+#endif
+  ScanSlotsScalar(present, evictable, keys, i, num_slots, best_key, best_slot);
+}
+/** @brief Number of replacer shards: the hardware thread count rounded up to a power of two. */
+auto NumShards() -> size_t {
+  size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+  size_t num_shards = 1;
+  while (num_shards < num_threads) {
+    num_shards <<= 1;
+  }
+  return num_shards;
+}
+}  // namespace
+
 /**
  *
  * TODO(P1): Add implementation
@@ -25,17 +119,29 @@ namespace bustub {
  * @brief a new LRUKReplacer.
  * @param num_frames the maximum number of frames the LRUReplacer will be required to store
  */
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
-void PrintNodeStore(const std::unordered_map<frame_id_t, LRUKNode> &node_store) {
-  for (const auto &[fid, node] : node_store) {
-    std::cout << "Frame ID: " << fid << "\n";
-    std::cout << "  k: " << node.k_ << "\n";
-    std::cout << "  is_evictable: " << (node.is_evictable_ ? "true" : "false") << "\n";
-    std::cout << "  History timestamps: ";
-    for (size_t ts : node.history_) {
-      std::cout << ts << " ";
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : shards_(NumShards()), replacer_size_(num_frames), k_(k) {
+  shard_mask_ = shards_.size() - 1;
+  shard_bits_ = 0;
+  while ((static_cast<size_t>(1) << shard_bits_) < shards_.size()) {
+    shard_bits_++;
+  }
+  // Each shard owns the frames whose low bits select it; size the arrays to their final
+  // capacity up front so no insert ever triggers a grow or rehash later.
+  const size_t frames_per_shard = (num_frames >> shard_bits_) + 1;
+  for (auto &shard : shards_) {
+    shard.present_.resize(frames_per_shard, 0);
+    shard.is_evictable_.resize(frames_per_shard, 0);
+    shard.count_.resize(frames_per_shard, 0);
+    shard.last_ts_.resize(frames_per_shard, 0);
+    shard.kth_ts_.resize(frames_per_shard, 0);
+    shard.sort_key_.resize(frames_per_shard, std::numeric_limits<size_t>::max());
+    // For k <= 2 the k-th most recent timestamp is derived from last_ts_ on each access
+    // (the buffer pool's usual configuration is k == 2), so the rings are only needed
+    // for larger k.
+    if (k_ > 2) {
+      shard.rings_.resize(frames_per_shard * k_, 0);
+      shard.ring_head_.resize(frames_per_shard, 0);
     }
-    std::cout << "\n\n";
   }
 }
 /**
@@ -54,38 +160,51 @@ void PrintNodeStore(const std::unordered_map<frame_id_t, LRUKNode> &node_store)
  * @return the frame ID if a frame is successfully evicted, or `std::nullopt` if no frames can be evicted.
  */
 auto LRUKReplacer::Evict() -> std::optional<frame_id_t> {
-  //PrintNodeStore(node_store_);
-  size_t oldest_time = std::numeric_limits<unsigned long>::max();
-  size_t biggest_k = 0;
-  frame_id_t oldest_time_id = -1;
-  frame_id_t biggest_k_id = -1;
-  for (const auto &[frame_id, node] : node_store_) {
-    if (node.history_.size() < k_) {
-      auto last_time_entry = node.history_.back();
-      if (last_time_entry < oldest_time && node.is_evictable_) {
-        oldest_time = last_time_entry;
-        oldest_time_id = frame_id;
-        // std::cout << "Oldest Node: " << frame_id << std::endl;
+  while (true) {
+    // Phase 1: scan each shard's metadata arrays under that shard's latch only. The
+    // composite sort key already encodes both the LRU-K tier and the ordering timestamp,
+    // so victim selection is a single branchless min-reduction: ineligible frames are
+    // forced to the maximum key by a mask instead of a skip branch, and the running
+    // minimum is updated with selects the compiler turns into cmovs.
+    size_t best_key = std::numeric_limits<size_t>::max();
+    frame_id_t victim = -1;
+    for (size_t shard_idx = 0; shard_idx < shards_.size(); shard_idx++) {
+      Shard &shard = shards_[shard_idx];
+      std::scoped_lock lock(shard.latch_);
+      size_t shard_best_key = std::numeric_limits<size_t>::max();
+      size_t shard_best_slot = 0;
+      ScanSlots(shard.present_.data(), shard.is_evictable_.data(), shard.sort_key_.data(), shard.present_.size(),
+                shard_best_key, shard_best_slot);
+      if (shard_best_key < best_key) {
+        best_key = shard_best_key;
+        victim = static_cast<frame_id_t>((shard_best_slot << shard_bits_) | shard_idx);
       }
-      continue;
     }
-    auto time_entry_at_k = *std::prev(node.history_.end(), k_);
-    // std::cout << "Checking Node: " << frame_id << " time stamp at k" << time_entry_at_k << " Biggest K:" << biggest_k << std::endl;
-    auto time_entry_at_latest = NowNanos();
-    if (time_entry_at_latest - time_entry_at_k > biggest_k && node.is_evictable_) {
-      biggest_k = time_entry_at_latest - time_entry_at_k;
-      biggest_k_id = frame_id;
-    //   std::cout << "Biggest K: " << frame_id << std::endl;
+    if (victim == -1) {
+      return std::nullopt;
+    }
+    // Phase 2: revalidate the snapshot under the owning shard's latch. The candidate is
+    // only evicted if its sort key is unchanged since phase 1; a reaccess, pin, or
+    // removal in the meantime invalidates the snapshot and we pick again.
+    Shard &shard = ShardFor(victim);
+    std::scoped_lock lock(shard.latch_);
+    const size_t idx = LocalIndex(victim);
+    if (shard.present_[idx] != 0 && shard.is_evictable_[idx] != 0 && shard.sort_key_[idx] == best_key) {
+      RemoveLocked(shard, idx);
+      return victim;
     }
   }
-  if (oldest_time_id != -1) {
-    Remove(oldest_time_id);
-    return oldest_time_id;
-  } else if (biggest_k_id != -1) {
-    Remove(biggest_k_id);
-    return biggest_k_id;
+}
+
+void LRUKReplacer::RemoveLocked(Shard &shard, size_t idx) {
+  shard.present_[idx] = 0;
+  shard.is_evictable_[idx] = 0;
+  shard.count_[idx] = 0;
+  if (k_ > 2) {
+    shard.ring_head_[idx] = 0;
   }
-  return std::nullopt;
+  shard.sort_key_[idx] = std::numeric_limits<size_t>::max();
+  shard.curr_size_.fetch_sub(1, std::memory_order_relaxed);
 }
 
 /**
@@ -102,14 +221,43 @@ auto LRUKReplacer::Evict() -> std::optional<frame_id_t> {
  * leaderboard tests.
  */
 void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {
-  auto it = node_store_.find(frame_id);
-  if (it != node_store_.end()) {
-    LRUKNode &node = it->second;
-    auto now = NowNanos();
-    node.history_.push_back(now);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+    throw bustub::Exception("Invalid frame id");
+  }
+  // One logical tick per access; everything below compares stored timestamps.
+  const auto now = current_timestamp_.fetch_add(1, std::memory_order_relaxed) + 1;
+  Shard &shard = ShardFor(frame_id);
+  std::scoped_lock lock(shard.latch_);
+  const size_t idx = LocalIndex(frame_id);
+  if (shard.present_[idx] == 0) {
+    shard.present_[idx] = 1;
+    shard.is_evictable_[idx] = 0;
+    shard.count_[idx] = 0;
+    if (k_ > 2) {
+      shard.ring_head_[idx] = 0;
+    }
+  }
+  if (k_ <= 2) {
+    // The k-th most recent access is the previous one for k == 2 (and this one for
+    // k == 1), so shifting last_ts_ into kth_ts_ replaces the ring entirely and the
+    // whole frame record stays within the hot columns.
+    shard.kth_ts_[idx] = (k_ == 1) ? now : shard.last_ts_[idx];
+  } else {
+    // Push the new timestamp into the frame's ring; the slot at ring_head_ afterwards is
+    // the oldest of the last k accesses, i.e. the k-th most recent once the ring is full.
+    const size_t base = idx * k_;
+    shard.rings_[base + shard.ring_head_[idx]] = now;
+    shard.ring_head_[idx] = (shard.ring_head_[idx] + 1) % k_;
+    shard.kth_ts_[idx] = shard.rings_[base + shard.ring_head_[idx]];
+  }
+  if (shard.count_[idx] < k_) {
+    shard.count_[idx]++;
+  }
+  shard.last_ts_[idx] = now;
+  if (shard.count_[idx] == k_) {
+    shard.sort_key_[idx] = kCacheTierBit | shard.kth_ts_[idx];
   } else {
-    node_store_.try_emplace(frame_id, LRUKNode(k_, frame_id));
-    // std::cout << "Node not found for frame_id: " << frame_id << " record access for now: " << NowNanos() << std::endl;
+    shard.sort_key_[idx] = now;
   }
 }
 
@@ -131,11 +279,17 @@ void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType
  * @param set_evictable whether the given frame is evictable or not
  */
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
-  auto it = node_store_.find(frame_id);
-  if (it != node_store_.end()) {
-    LRUKNode &node = it->second;
-    //std::cout << node.fid_ << " set evictable" << std::endl;
-    node.is_evictable_ = set_evictable;
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+    return;
+  }
+  Shard &shard = ShardFor(frame_id);
+  std::scoped_lock lock(shard.latch_);
+  const size_t idx = LocalIndex(frame_id);
+  if (shard.present_[idx] != 0) {
+    if ((shard.is_evictable_[idx] != 0) != set_evictable) {
+      shard.curr_size_.fetch_add(set_evictable ? 1 : -1, std::memory_order_relaxed);
+      shard.is_evictable_[idx] = set_evictable ? 1 : 0;
+    }
   }
 }
 
@@ -157,12 +311,15 @@ void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
  * @param frame_id id of frame to be removed
  */
 void LRUKReplacer::Remove(frame_id_t frame_id) {
-  auto it = node_store_.find(frame_id);
-  if (it != node_store_.end()) {
-    LRUKNode &node = it->second;
-    if (node.is_evictable_ == true) {
-    //   std::cout << "removing frame : " << frame_id << std::endl;
-      node_store_.erase(frame_id);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+    return;
+  }
+  Shard &shard = ShardFor(frame_id);
+  std::scoped_lock lock(shard.latch_);
+  const size_t idx = LocalIndex(frame_id);
+  if (shard.present_[idx] != 0) {
+    if (shard.is_evictable_[idx] != 0) {
+      RemoveLocked(shard, idx);
     } else {
       throw bustub::Exception("Node is not evictable");
     }
@@ -177,12 +334,9 @@ void LRUKReplacer::Remove(frame_id_t frame_id) {
  * @return size_t
  */
 auto LRUKReplacer::Size() -> size_t {
-  auto size = 0;
-  for (const auto &[frame_id, node] : node_store_) {
-    if (node.is_evictable_ == true) {
-      size++;
-    }
-    // std::cout << "Frame ID: " << frame_id << " evictable" << std::endl;
+  size_t size = 0;
+  for (auto &shard : shards_) {
+    size += shard.curr_size_.load(std::memory_order_relaxed);
   }
   return size;
 }
@@ -12,11 +12,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
 #include <optional>
-#include <unordered_map>
 #include <vector>
 
 #include "buffer/arc_replacer.h"
@@ -25,26 +25,6 @@
 
 namespace bustub {
 
-static inline size_t NowNanos() {
-  return std::chrono::duration_cast<std::chrono::nanoseconds>(
-           std::chrono::steady_clock::now().time_since_epoch()
-         ).count();
-}
-
-class LRUKNode {
- public:
-  /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
-  LRUKNode(size_t k, frame_id_t fid, bool evictable = false)
-      : k_(k), fid_(fid), is_evictable_(evictable) {
-    history_.push_back(NowNanos());
-  }
-  [[maybe_unused]] std::list<size_t> history_;
-  [[maybe_unused]] size_t k_;
-  [[maybe_unused]] frame_id_t fid_;
-  [[maybe_unused]] bool is_evictable_{false};
-};
-
 /**
  * LRUKReplacer implements the LRU-k replacement policy.
  *
@@ -80,14 +60,60 @@ class LRUKReplacer {
   auto Size() -> size_t;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] std::unordered_map<frame_id_t, LRUKNode> node_store_;
-  [[maybe_unused]] size_t current_timestamp_{0};
-  [[maybe_unused]] size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
-  [[maybe_unused]] std::mutex latch_;
+  /**
+   * A slice of the frame space with its own latch and frame metadata. Frames are
+   * assigned to shards by `frame_id & shard_mask_`; within a shard, a frame lives at
+   * local index `frame_id >> shard_bits_` in every array.
+   *
+   * The metadata is stored as parallel arrays (structure-of-arrays) rather than an
+   * array of node structs, so the eviction scan streams only the columns it actually
+   * reads - the evictable flags and the ordering timestamps - instead of dragging each
+   * frame's whole record through the cache.
+   */
+  struct Shard {
+    /** Whether the slot currently holds a tracked frame. */
+    std::vector<uint8_t> present_;
+    std::vector<uint8_t> is_evictable_;
+    /** Number of recorded accesses, saturating at k. */
+    std::vector<size_t> count_;
+    /** Most recent access timestamp; orders eviction among frames with fewer than k accesses. */
+    std::vector<size_t> last_ts_;
+    /** K-th most recent access timestamp; only meaningful once `count_` reaches k. */
+    std::vector<size_t> kth_ts_;
+    /** Composite eviction key: `last_ts_` while the frame has fewer than k accesses,
+     *  `kCacheTierBit | kth_ts_` afterwards. Minimizing this single column picks the
+     *  LRU-K victim - the tier bit makes every under-k frame rank below every cached
+     *  frame, matching their +inf backward k-distance. */
+    std::vector<size_t> sort_key_;
+    /** Per-frame rings of the last k access timestamps, k consecutive slots per frame.
+     *  `ring_head_` is the slot the next access overwrites, i.e. the oldest entry when full.
+     *  Only allocated for k > 2; for smaller k the k-th timestamp is derived from
+     *  `last_ts_` directly. */
+    std::vector<size_t> rings_;
+    std::vector<size_t> ring_head_;
+    /** Number of evictable frames in this shard; atomic so Size() can sum without taking latches. */
+    std::atomic<size_t> curr_size_{0};
+    std::mutex latch_;
+  };
+
+  /** Set in a frame's sort key once it has k recorded accesses. Logical timestamps are
+   *  far from 2^63, so the bit never collides with a real timestamp. */
+  static constexpr size_t kCacheTierBit = static_cast<size_t>(1) << 63;
+
+  auto ShardFor(frame_id_t frame_id) -> Shard & { return shards_[frame_id & shard_mask_]; }
+  auto LocalIndex(frame_id_t frame_id) const -> size_t { return static_cast<size_t>(frame_id) >> shard_bits_; }
+
+  /** @brief Clear the frame's slot and drop it from the evictable count. Caller must hold the shard latch. */
+  void RemoveLocked(Shard &shard, size_t idx);
+
+  std::vector<Shard> shards_;
+  size_t shard_bits_;
+  size_t shard_mask_;
+  /** Logical clock, bumped on every RecordAccess. Only the relative order of timestamps
+   *  matters for LRU-K; atomic so timestamps stay comparable across shards. */
+  std::atomic<size_t> current_timestamp_{0};
+  size_t replacer_size_;
+  size_t k_;
 };
 
 }  // namespace bustub
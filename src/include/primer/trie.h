@@ -15,11 +15,11 @@
 #include <algorithm>
 #include <cstddef>
 #include <future>  // NOLINT
-#include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <typeinfo>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -59,7 +59,7 @@ class TrieNode {
   TrieNode() = default;
 
   // Create a TrieNode with some children.
-  explicit TrieNode(std::map<char, std::shared_ptr<const TrieNode>> children) : children_(std::move(children)) {}
+  explicit TrieNode(std::unordered_map<char, std::shared_ptr<const TrieNode>> children) : children_(std::move(children)) {}
 
   virtual ~TrieNode() = default;
 
@@ -72,10 +72,14 @@ class TrieNode {
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
   virtual auto Clone() const -> std::unique_ptr<TrieNode> { return std::make_unique<TrieNode>(children_); }
 
+  // Type of the value stored at this node, or nullptr for a plain node. Lets Get verify the
+  // value type with a single type_info comparison instead of a dynamic_cast RTTI walk.
+  virtual auto ValueType() const -> const std::type_info * { return nullptr; }
+
   // A map of children, where the key is the next character in the key, and the value is the next TrieNode.
   // You MUST store the children information in this structure. You are NOT allowed to remove the `const` from
   // the structure.
-  std::map<char, std::shared_ptr<const TrieNode>> children_;
+  std::unordered_map<char, std::shared_ptr<const TrieNode>> children_;
 
   // Indicates if the node is the terminal node.
   bool is_value_node_{false};
@@ -92,7 +96,7 @@ class TrieNodeWithValue : public TrieNode {
   explicit TrieNodeWithValue(std::shared_ptr<T> value) : value_(std::move(value)) { this->is_value_node_ = true; }
 
   // Create a trie node with children and a value.
-  TrieNodeWithValue(std::map<char, std::shared_ptr<const TrieNode>> children, std::shared_ptr<T> value)
+  TrieNodeWithValue(std::unordered_map<char, std::shared_ptr<const TrieNode>> children, std::shared_ptr<T> value)
       : TrieNode(std::move(children)), value_(std::move(value)) {
     this->is_value_node_ = true;
   }
@@ -104,6 +108,8 @@ class TrieNodeWithValue : public TrieNode {
     return std::make_unique<TrieNodeWithValue<T>>(children_, value_);
   }
 
+  auto ValueType() const -> const std::type_info * override { return &typeid(T); }
+
   // The value associated with this trie node.
   std::shared_ptr<T> value_;
 };
@@ -137,4 +143,91 @@ class Trie {
   auto GetRoot() const -> std::shared_ptr<const TrieNode> { return root_; }
 };
 
+// The templated Get/Put bodies live here in the header (instead of being explicitly
+// instantiated in trie.cpp) so the compiler can inline them into callers and
+// specialize them for every value type; only the non-templated Remove stays in the
+// translation unit.
+
+/**
+ * @brief Get the value associated with the given key.
+ * 1. If the key is not in the trie, return nullptr.
+ * 2. If the key is in the trie but the type is mismatched, return nullptr.
+ * 3. Otherwise, return the value.
+ */
+template <class T>
+auto Trie::Get(std::string_view key) const -> const T * {
+  // root_ keeps every node on the path alive for the duration of this call, so the walk
+  // uses raw pointers and never touches the atomic refcounts a shared_ptr copy per
+  // character would churn.
+  const TrieNode *currentNode = this->root_.get();
+  for (char ch : key) {
+    if (currentNode == nullptr) {
+      return nullptr;
+    }
+    auto findnode = currentNode->children_.find(ch);
+    if (findnode == currentNode->children_.end())
+      return nullptr;
+    else
+      currentNode = findnode->second.get();
+  }
+  if (currentNode == nullptr) {
+    return nullptr;
+  }
+  // A matching type tag proves the node is a TrieNodeWithValue<T>, so a static_cast suffices.
+  const std::type_info *value_type = currentNode->ValueType();
+  if (value_type == nullptr || *value_type != typeid(T)) {
+    return nullptr;
+  }
+  return static_cast<const TrieNodeWithValue<T> *>(currentNode)->value_.get();
+}
+
+namespace detail {
+
+/**
+ * @brief Rebuild the path for `key` below `node` in a single top-down pass.
+ *
+ * Clones `node` (or starts a fresh one when the path did not exist), recurses on the
+ * first key character, and splices the rebuilt child into the clone, so no parents
+ * stack or second traversal is needed. At the end of the key the value is attached,
+ * preserving any existing children.
+ */
+template <class T>
+auto PutImpl(const std::shared_ptr<const TrieNode> &node, std::string_view key, std::shared_ptr<T> value)
+    -> std::shared_ptr<const TrieNode> {
+  if (key.empty()) {
+    if (node == nullptr) {
+      return std::make_shared<TrieNodeWithValue<T>>(std::move(value));
+    }
+    return std::make_shared<TrieNodeWithValue<T>>(node->children_, std::move(value));
+  }
+  // Point at the existing child instead of copying its shared_ptr; `node` keeps it
+  // alive across the recursion, so the descent performs no refcount traffic.
+  static const std::shared_ptr<const TrieNode> kNoChild = nullptr;
+  const std::shared_ptr<const TrieNode> *child = &kNoChild;
+  std::shared_ptr<TrieNode> cloned_node;
+  if (node != nullptr) {
+    auto findnode = node->children_.find(key[0]);
+    if (findnode != node->children_.end()) {
+      child = &findnode->second;
+    }
+    cloned_node = node->Clone();
+  } else {
+    cloned_node = std::make_shared<TrieNode>();
+  }
+  cloned_node->children_[key[0]] = PutImpl(*child, key.substr(1), std::move(value));
+  return cloned_node;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Put a new key-value pair into the trie. If the key already exists, overwrite the value.
+ * @return the new trie.
+ */
+template <class T>
+auto Trie::Put(std::string_view key, T value) const -> Trie {
+  // Note that `T` might be a non-copyable type. Always use `std::move` when creating `shared_ptr` on that value.
+  return Trie{detail::PutImpl(this->root_, key, std::make_shared<T>(std::move(value)))};
+}
+
 }  // namespace bustub